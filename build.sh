@@ -9,9 +9,13 @@ echo $@
 
 # Build without running
 if [ $(expr index $@ c) -gt 0 ]; then
-    gcc -g racing_chatgpt.c -lncurses -lm -o chatgpt;
+    gcc -g racing_chatgpt.c -lncurses -lm -lrt -pthread -o chatgpt;
 elif [ $(expr index $@ g) -gt 0 ]; then
     gcc -g racing_gemini.c  -lncurses -lm -o gemini;
+elif [ $(expr index $@ p) -gt 0 ]; then
+    gcc -g racing_top.c     -lncurses -lrt -o racing-top;
+elif [ $(expr index $@ s) -gt 0 ]; then
+    gcc -g racing_stats.c   -o racing-stats;
 elif [ $(expr index $@ k) -gt 0 ]; then
     gcc -g racing_grock.c   -lncurses -o grock;
 else
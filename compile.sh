@@ -9,11 +9,17 @@ echo $@
 
 # Build & run
 if [ $(expr index $@ c) -gt 0 ]; then
-    gcc -g racing_chatgpt.c -lncurses -lm -o chatgpt;
+    gcc -g racing_chatgpt.c -lncurses -lm -lrt -pthread -o chatgpt;
     ./chatgpt
 elif [ $(expr index $@ g) -gt 0 ]; then
     gcc -g racing_gemini.c  -lncurses -lm -o gemini;
     ./gemini
+elif [ $(expr index $@ p) -gt 0 ]; then
+    gcc -g racing_top.c     -lncurses -lrt -o racing-top;
+    ./racing-top
+elif [ $(expr index $@ s) -gt 0 ]; then
+    gcc -g racing_stats.c   -o racing-stats;
+    ./racing-stats
 elif [ $(expr index $@ k) -gt 0 ]; then
     gcc -g racing_grock.c   -lncurses -o grock;
     ./grock
@@ -4,25 +4,50 @@
      Flechas izquierda/derecha -> mover coche
      Flechas arriba/abajo -> velocidad
      Ratón (botón izquierdo) -> mover coche a la X del clic
+     Redimensionar el terminal -> la carretera se reajusta sin reiniciar
+   Modo torneo (bots, una ventana por partida):
+     ./chatgpt -n 16 [-s semilla] [-l velocidad]
    Compilar:
-     gcc -o road_game road_game.c -lncurses -O2
+     gcc -o road_game road_game.c -lncurses -lm -lrt -pthread -O2
 */
 
 /* Solamente actualiza la posición de la nave con cada scroll */
 
 #include <ncurses.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
 #include <math.h>
+#include <pthread.h>
+#include "racing_telemetry.h"
+#include "racing_stats.h"
 
 #define MIN(a,b) ((a)<(b)?(a):(b))
 
-/* Configuración del juego */
+/* Configuración por defecto: cada partida copia estos valores en su GameState */
 static int ROAD_HALF_WIDTH = 12;   /* mitad del ancho de la carretera (en cols) */
 static int TICK_MICROS_MIN = 35000;/* velocidad máxima (microseg) */
 static int TICK_MICROS_MAX = 150000;/* velocidad mínima (microseg) */
 
+/* Modo torneo */
+#define MAX_GAMES     64
+#define MAX_CATCHUP   4    /* ticks atrasados que se recuperan en un frame */
+#define PANEL_MIN_W   12
+#define PANEL_MIN_H   5
+
+/* Altura mínima de la carretera: el coche va en rows - 3 */
+#define ROAD_MIN_HEIGHT 3
+
+/* Segmento de telemetría para racing-top (NULL si no hay /dev/shm) */
+static Telemetry *telem = NULL;
+
+/* Estadísticas persistentes (stats.log == NULL si no se pudieron abrir) */
+static RunStats stats;
+
+/* ncurses ya atiende SIGWINCH (resizeterm + KEY_RESIZE): sólo anotamos que hay que reajustar */
+static int resize_pending = 0;
+
 /* Estados del juego */
 typedef struct {
     int cols, rows;
@@ -30,6 +55,14 @@ typedef struct {
     int speed_level; /* 0..5, 0 lento, 5 rapido */
     int running;
     int score;
+    int road_half_width;
+    int tick_us_min, tick_us_max;
+    unsigned int seed; /* estado de rand_r: cada partida su propia secuencia */
+    /* partida en curso, para las estadísticas */
+    unsigned int run_seed; /* seed al empezar: la carretera sólo depende de ella */
+    uint64_t start_ms;
+    int ticks;
+    int max_speed;
 } GameState;
 
 /* Camino: para cada fila tenemos el centro X de la carretera */
@@ -71,7 +104,8 @@ static void road_free(Road *r) {
 }
 
 /* shift road down by one and generate new center at top using simple random walk */
-static void road_scroll_and_generate(Road *r, int cols) {
+static void road_scroll_and_generate(Road *r, GameState *g) {
+    int cols = g->cols;
     /* move down */
     for (int i = r->len - 1; i > 0; --i){
         r->centers[i] = r->centers[i-1];
@@ -81,9 +115,9 @@ static void road_scroll_and_generate(Road *r, int cols) {
     int prev = r->centers[1]; /* previous top-most meaningful */
     if (prev == 0) 
         prev = cols / 2;
-    int change = (rand() % 7) - 3; /* -3..3 for stronger curves */
+    int change = (rand_r(&g->seed) % 7) - 3; /* -3..3 for stronger curves */
     int newc = prev + change;
-    int margin = ROAD_HALF_WIDTH + 2;
+    int margin = g->road_half_width + 2;
     if (newc < margin)
         newc = margin;
     if (newc > cols - margin - 1) 
@@ -99,17 +133,18 @@ static void road_init(Road *r, int cols) {
     }
 }
 
-/* draw the road and car. Car is drawn near the bottom. */
-static void render(GameState *g, Road *road) {
-    erase();
+/* draw the road and car into w. Car is drawn near the bottom.
+   Only stages the window (wnoutrefresh): the caller does one doupdate() per frame. */
+static void render(WINDOW *w, GameState *g, Road *road, const char *hud) {
+    werase(w);
     int rows = g->rows;
     int cols = g->cols;
 
     /* Draw each row: road edges and fill */
     for (int row = 0; row < rows; ++row) {
         int center = road->centers[row];
-        int left = center - ROAD_HALF_WIDTH;
-        int right = center + ROAD_HALF_WIDTH;
+        int left = center - g->road_half_width;
+        int right = center + g->road_half_width;
         if (left < 0) 
             left = 0;
         if (right >= cols)
@@ -118,17 +153,17 @@ static void render(GameState *g, Road *road) {
         /* Draw fill */
         for (int c = 0; c < cols; ++c) {
             if (c == left || c == right) {
-                mvaddch(row, c, ACS_VLINE); /* border */
+                mvwaddch(w, row, c, ACS_VLINE); /* border */
             } else if (c > left && c < right) {
-                mvaddch(row, c, ' '); /* road interior blank */
+                mvwaddch(w, row, c, ' '); /* road interior blank */
             } else {
-                mvaddch(row, c, '.'); /* off-road texture */
+                mvwaddch(w, row, c, '.'); /* off-road texture */
             }
         }
 
         /* center dashed line */
         if (row % 4 == 0) {
-            if (center >= 0 && center < cols) mvaddch(row, center, ':');
+            if (center >= 0 && center < cols) mvwaddch(w, row, center, ':');
         }
     }
 
@@ -141,14 +176,14 @@ static void render(GameState *g, Road *road) {
             int X = px - 1 + c;
             int Y = py - (2 - r);
             if (X >= 0 && X < cols && Y >= 0 && Y < rows) {
-                mvaddch(Y, X, car[r][c]);
+                mvwaddch(w, Y, X, car[r][c]);
             }
         }
     }
 
-    /* HUD */
-    mvprintw(0, 1, "Score:%d  Speed:%d  Quit:q", g->score, g->speed_level);
-    refresh();
+    /* HUD, truncated so it never wraps in narrow panels */
+    mvwaddnstr(w, 0, 1, hud, cols - 2);
+    wnoutrefresh(w);
 }
 
 /* returns 1 if collision (car leaves road boundaries) */
@@ -160,8 +195,8 @@ static int check_collision(GameState *g, Road *r) {
     if (check_row >= r->len)
          check_row = r->len - 1;
     int center = r->centers[check_row];
-    int left = center - ROAD_HALF_WIDTH;
-    int right = center + ROAD_HALF_WIDTH;
+    int left = center - g->road_half_width;
+    int right = center + g->road_half_width;
     if (g->player_x < left + 1 || g->player_x > right - 1)
         return 1;
     return 0;
@@ -174,7 +209,9 @@ static int clamp(int v, int a, int b) { if (v<a) return a; if (v>b) return b; re
 static void handle_input(GameState *g) {
     int ch;
     MEVENT mev; //mouse Event
+    int events = 0;
     while ((ch = getch()) != ERR) {
+        events++;
         if (ch == 'q' || ch == 'Q') {
             g->running = 0;
             return;
@@ -186,6 +223,8 @@ static void handle_input(GameState *g) {
             if (g->speed_level < 5) g->speed_level++;
         } else if (ch == KEY_DOWN) {
             if (g->speed_level > 0) g->speed_level--;
+        } else if (ch == KEY_RESIZE) {
+            resize_pending = 1;
         } else if (ch == KEY_MOUSE) {
             if (getmouse(&mev) == OK) {
                 /* Button pressed or movement */
@@ -203,28 +242,363 @@ static void handle_input(GameState *g) {
             }
         }
     }
+    telemetry_input(telem, events);
     /* clamp to screen */
     g->player_x = clamp(g->player_x, 1, g->cols - 2);
 }
 
 /* compute tick delay from speed_level */
-static int compute_tick_us(int speed_level) {
+static int compute_tick_us(const GameState *g) {
     /* speed_level 0..5 map to delays */
-    int t = TICK_MICROS_MAX - ( (TICK_MICROS_MAX - TICK_MICROS_MIN) * speed_level / 5 );
+    int t = g->tick_us_max - ( (g->tick_us_max - g->tick_us_min) * g->speed_level / 5 );
     return t;
 }
 
-int main() {
-    srand(time(NULL));
-    init_ncurses();
+/* initialize a game for a rows x cols area with the default config */
+static void game_init(GameState *g, int rows, int cols, unsigned int seed) {
+    if (rows < ROAD_MIN_HEIGHT) rows = ROAD_MIN_HEIGHT; /* ncurses clips what doesn't fit */
+    g->rows = rows;
+    g->cols = cols;
+    g->player_y = rows - 3; /* place car near bottom */
+    g->player_x = cols / 2;
+    g->speed_level = 3;
+    g->running = 1;
+    g->score = 0;
+    /* narrow panels get a narrower road so the margins still fit */
+    g->road_half_width = clamp(cols / 4, 3, ROAD_HALF_WIDTH);
+    g->tick_us_min = TICK_MICROS_MIN;
+    g->tick_us_max = TICK_MICROS_MAX;
+    g->seed = seed;
+}
+
+/* reflow a running game into a rows x cols area.
+   Only the row storage that changed is reallocated; the rows nearest the car
+   (the bottom) are kept and columns are scaled into the new width. */
+static void game_resize(GameState *g, Road *r, int rows, int cols) {
+    if (rows < ROAD_MIN_HEIGHT) rows = ROAD_MIN_HEIGHT; /* keep the car on the road */
+    /* car offset from the road center, to keep it in the same spot of the road */
+    int old_half = g->road_half_width;
+    int offset = g->player_x - r->centers[clamp(g->player_y, 0, r->len - 1)];
+    int d = rows - r->len;
+    if (d < 0) {
+        /* drop the far rows at the top */
+        memmove(r->centers, r->centers - d, sizeof(int) * rows);
+        r->centers = realloc(r->centers, sizeof(int) * rows);
+    } else if (d > 0) {
+        r->centers = realloc(r->centers, sizeof(int) * rows);
+        memmove(r->centers + d, r->centers, sizeof(int) * r->len);
+        /* extend the far end straight: no rand_r, so the run still depends only on its seed */
+        for (int i = 0; i < d; ++i) r->centers[i] = r->centers[d];
+    }
+    r->len = rows;
+
+    g->road_half_width = clamp(cols / 4, 3, ROAD_HALF_WIDTH);
+    int margin = g->road_half_width + 2;
+    for (int i = 0; i < rows; ++i) {
+        int c = cols != g->cols ? r->centers[i] * cols / g->cols : r->centers[i];
+        r->centers[i] = clamp(c, margin, cols - margin - 1);
+    }
+    g->player_y = rows - 3;
+    g->player_x = clamp(r->centers[clamp(g->player_y, 0, rows - 1)] + offset * g->road_half_width / old_half,
+                        1, cols - 2);
+    g->rows = rows;
+    g->cols = cols;
+}
+
+/* start a new run from the current RNG state */
+static void game_start_run(GameState *g) {
+    g->run_seed = g->seed;
+    g->start_ms = stats_now_ms();
+    g->ticks = 0;
+    g->max_speed = g->speed_level;
+}
+
+/* append the finished run to the persistent stats (flags: RUN_BOT for tournament bots) */
+static void game_record(const GameState *g, int crashed, int flags) {
+    RunRecord r = {0};
+    r.seed = g->run_seed;
+    r.score = g->score;
+    r.duration_ms = (uint32_t)(stats_now_ms() - g->start_ms);
+    r.crash_tick = crashed ? (uint32_t)g->ticks : 0;
+    r.max_speed = (uint16_t)g->max_speed;
+    r.variant = VARIANT_CHATGPT;
+    r.flags = (uint8_t)flags;
+    stats_append(&stats, &r);
+}
+
+/* ---------------------------------------------------------------------- */
+/* Modo torneo: N partidas independientes, cada una en su propia ventana.
+   Los workers sólo simulan (ncurses no es thread-safe); el hilo principal
+   hace de compositor: repinta las ventanas que avanzaron y un doupdate(). */
+
+typedef struct {
+    WINDOW *win;
+    GameState g;
+    Road *road;
+    Telemetry *telem;
+    uint64_t next_tick_ns;
+    int crashed;
+    int recorded; /* ya guardada en las estadísticas */
+    int dirty;   /* avanzó en este frame: hay que repintarla */
+} Instance;
+
+typedef struct {
+    Instance *inst;
+    int n;
+    int nworkers;
+    uint64_t now_ns;   /* hora del frame, escrita antes de la barrera */
+    int quit;
+    pthread_mutex_t setup; /* retiene a los workers hasta que las barreras existen */
+    pthread_barrier_t start, done;
+} Tournament;
+
+typedef struct {
+    Tournament *t;
+    int id;
+} Worker;
+
+/* bot: steer towards the center of the road a few rows ahead.
+   returns the number of simulated key presses */
+static int bot_input(GameState *g, Road *r) {
+    int ahead = clamp(g->player_y - 1 - g->speed_level / 2, 0, r->len - 1);
+    int target = r->centers[ahead];
+    if (rand_r(&g->seed) % 4 == 0)
+        return 0; /* reaction lag, or nobody would ever crash */
+    if (g->player_x < target - 1) {
+        g->player_x += 2;
+    } else if (g->player_x > target + 1) {
+        g->player_x -= 2;
+    } else {
+        return 0;
+    }
+    g->player_x = clamp(g->player_x, 1, g->cols - 2);
+    return 1;
+}
+
+/* advance one instance by one tick (runs on a worker thread) */
+static void instance_tick(Instance *in) {
+    uint64_t tick_start = telemetry_now_ns();
+    GameState *g = &in->g;
+
+    g->ticks++;
+    telemetry_input(in->telem, bot_input(g, in->road));
+    int steps = 1 + g->speed_level / 2;
+    for (int s = 0; s < steps; ++s) {
+        road_scroll_and_generate(in->road, g);
+        g->score++;
+    }
+    if (check_collision(g, in->road))
+        in->crashed = 1;
+
+    uint64_t tick_end = telemetry_now_ns();
+    telemetry_tick(in->telem, tick_end, tick_end - tick_start, g->score, g->speed_level);
+    in->next_tick_ns += (uint64_t)compute_tick_us(g) * 1000;
+    in->dirty = 1;
+}
+
+/* run every due tick of this worker's share of instances */
+static void tournament_step(Tournament *t, int id) {
+    for (int i = id; i < t->n; i += t->nworkers) {
+        Instance *in = &t->inst[i];
+        int k = 0;
+        while (!in->crashed && in->next_tick_ns <= t->now_ns && k++ < MAX_CATCHUP)
+            instance_tick(in);
+        /* too far behind: drop the backlog instead of spiralling */
+        if (in->next_tick_ns <= t->now_ns)
+            in->next_tick_ns = t->now_ns + (uint64_t)compute_tick_us(&in->g) * 1000;
+    }
+}
+
+static void *tournament_worker(void *arg) {
+    Worker *w = arg;
+    Tournament *t = w->t;
+    pthread_mutex_lock(&t->setup);
+    pthread_mutex_unlock(&t->setup);
+    for (;;) {
+        pthread_barrier_wait(&t->start);
+        if (t->quit)
+            break;
+        tournament_step(t, w->id);
+        pthread_barrier_wait(&t->done);
+    }
+    return NULL;
+}
+
+/* grid of gc x gr panels of pw x ph for n games in the current terminal,
+   1 column gap between them; -1 if the panels would be too small */
+static int tournament_grid(int n, int *gc, int *pw, int *ph) {
+    *gc = 1;
+    while (*gc * *gc < n) (*gc)++;
+    int gr = (n + *gc - 1) / *gc;
+    *pw = COLS / *gc;
+    *ph = LINES / gr;
+    return *pw - 1 < PANEL_MIN_W || *ph < PANEL_MIN_H ? -1 : 0;
+}
+
+/* tile the terminal. Used at start and on every resize; -1 if too small */
+static int tournament_layout(Tournament *t) {
+    int gc, pw, ph;
+    if (tournament_grid(t->n, &gc, &pw, &ph) < 0)
+        return -1;
+    for (int i = 0; i < t->n; ++i) {
+        Instance *in = &t->inst[i];
+        wresize(in->win, ph, pw - 1);
+        mvwin(in->win, (i / gc) * ph, (i % gc) * pw);
+        game_resize(&in->g, in->road, ph, pw - 1);
+        in->dirty = 1;
+    }
+    return 0;
+}
+
+static void render_instance(Instance *in, int id) {
+    char hud[64];
+    if (in->crashed)
+        snprintf(hud, sizeof(hud), "#%d CRASH Score:%d", id, in->g.score);
+    else
+        snprintf(hud, sizeof(hud), "#%d Score:%d Speed:%d", id, in->g.score, in->g.speed_level);
+    render(in->win, &in->g, in->road, hud);
+    in->dirty = 0;
+}
+
+static int play_tournament(int n, unsigned int seed, int level) {
+    refresh(); /* flush stdscr once so getch() never repaints it over the panels */
+
+    /* check the size before creating windows and /dev/shm segments */
+    int gc, pw, ph;
+    if (tournament_grid(n, &gc, &pw, &ph) < 0) {
+        end_ncurses();
+        fprintf(stderr, "Terminal demasiado pequeño para %d partidas (%dx%d)\n", n, COLS, LINES);
+        return 1;
+    }
+
+    /* games start as 1x1 and tournament_layout() gives them their panel */
+    Tournament t = { .n = n, .setup = PTHREAD_MUTEX_INITIALIZER };
+    t.inst = calloc(n, sizeof(Instance));
+    uint64_t now = telemetry_now_ns();
+    for (int i = 0; i < n; ++i) {
+        Instance *in = &t.inst[i];
+        in->win = newwin(1, 1, 0, 0);
+        game_init(&in->g, 1, 1, seed + i);
+        in->g.speed_level = level >= 0 ? level : i % 6; /* por defecto compara velocidades */
+        game_start_run(&in->g);
+        in->road = road_create(in->g.rows);
+        in->telem = telemetry_create(i);
+        in->next_tick_ns = now;
+    }
+    tournament_layout(&t);
+    for (int i = 0; i < n; ++i) {
+        Instance *in = &t.inst[i];
+        for (int r = 0; r < in->road->len; ++r) in->road->centers[r] = in->g.cols / 2;
+        in->g.player_x = in->g.cols / 2;
+    }
+
+    /* the main thread is worker 0. The barriers are sized once we know how
+       many threads really started; until then the workers wait on t.setup */
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    int want = clamp(ncpu > 0 ? (int)ncpu : 1, 1, n);
+    pthread_t *threads = calloc(want, sizeof(pthread_t));
+    Worker *workers = calloc(want, sizeof(Worker));
+    pthread_mutex_lock(&t.setup);
+    t.nworkers = 1;
+    for (int w = 1; w < want; ++w) {
+        workers[w] = (Worker){ &t, w };
+        if (pthread_create(&threads[w], NULL, tournament_worker, &workers[w]) != 0)
+            break; /* seguimos con los que arrancaron; como poco, el hilo principal */
+        t.nworkers++;
+    }
+    pthread_barrier_init(&t.start, NULL, t.nworkers);
+    pthread_barrier_init(&t.done, NULL, t.nworkers);
+    pthread_mutex_unlock(&t.setup);
+
+    int running = 1;
+    while (running) {
+        int ch;
+        while ((ch = getch()) != ERR) {
+            if (ch == 'q' || ch == 'Q') running = 0;
+            if (ch == KEY_RESIZE) resize_pending = 1;
+        }
+
+        /* re-tile between frames, while the workers are parked at the barrier.
+           If the new size is too small the old layout stays (ncurses clips it) */
+        if (resize_pending) {
+            resize_pending = 0;
+            if (tournament_layout(&t) == 0) {
+                erase();
+                wnoutrefresh(stdscr); /* clear the gaps between panels */
+                clearok(curscr, TRUE);
+            }
+        }
 
+        /* simulate in parallel */
+        t.now_ns = telemetry_now_ns();
+        pthread_barrier_wait(&t.start);
+        tournament_step(&t, 0);
+        pthread_barrier_wait(&t.done);
+
+        /* compose: one refresh per frame */
+        uint64_t next = UINT64_MAX;
+        int alive = 0;
+        for (int i = 0; i < n; ++i) {
+            Instance *in = &t.inst[i];
+            if (in->dirty)
+                render_instance(in, i);
+            if (in->crashed && !in->recorded) {
+                game_record(&in->g, 1, RUN_BOT);
+                in->recorded = 1;
+            }
+            if (!in->crashed) {
+                alive++;
+                if (in->next_tick_ns < next) next = in->next_tick_ns;
+            }
+        }
+        doupdate();
+
+        /* sleep until the next instance is due (or poll keys when all crashed) */
+        now = telemetry_now_ns();
+        if (!alive)
+            usleep(TICK_MICROS_MAX);
+        else if (next > now)
+            usleep((next - now) / 1000);
+    }
+
+    t.quit = 1;
+    pthread_barrier_wait(&t.start);
+    for (int w = 1; w < t.nworkers; ++w)
+        pthread_join(threads[w], NULL);
+    pthread_barrier_destroy(&t.start);
+    pthread_barrier_destroy(&t.done);
+    pthread_mutex_destroy(&t.setup);
+    end_ncurses();
+
+    /* results */
+    printf("Torneo: %d partidas, semilla %u\n", n, seed);
+    for (int i = 0; i < n; ++i) {
+        Instance *in = &t.inst[i];
+        printf("  #%-2d seed:%-10u speed:%d score:%-7d %s\n", i, seed + i,
+               in->g.speed_level, in->g.score, in->crashed ? "crash" : "");
+        if (!in->recorded)
+            game_record(&in->g, 0, RUN_BOT);
+        road_free(in->road);
+        telemetry_destroy(in->telem);
+        delwin(in->win);
+    }
+    free(workers);
+    free(threads);
+    free(t.inst);
+    return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+static int play_single(unsigned int seed, int level) {
     GameState g;
-    getmaxyx(stdscr, g.rows, g.cols);
-    g.player_y = g.rows - 3; /* place car near bottom */
-    g.player_x = g.cols / 2;
-    g.speed_level = 3;
-    g.running = 1;
-    g.score = 0;
+    int rows, cols;
+    getmaxyx(stdscr, rows, cols);
+    game_init(&g, rows, cols, seed);
+    if (level >= 0) g.speed_level = level;
+    game_start_run(&g);
+    int recorded = 0;
+    telem = telemetry_create(0);
 
     Road *road = road_create(g.rows);
     road_init(road, g.cols);
@@ -236,26 +610,50 @@ int main() {
 
     /* main loop */
     while (g.running) {
+        uint64_t frame_start = telemetry_now_ns();
         handle_input(&g);
+        if (resize_pending) {
+            /* reflow within this frame: no restart, no dropped tick */
+            int rows, cols;
+            getmaxyx(stdscr, rows, cols);
+            game_resize(&g, road, rows, cols);
+            clearok(curscr, TRUE); /* one full repaint */
+            resize_pending = 0;
+        }
+        g.ticks++;
+        if (g.speed_level > g.max_speed) g.max_speed = g.speed_level;
 
         /* scroll road according to speed */
         int steps = 1 + g.speed_level / 2; /* small relation to speed */
         for (int s = 0; s < steps; ++s) {
-            road_scroll_and_generate(road, g.cols);
+            road_scroll_and_generate(road, &g);
             g.score++;
         }
 
         /* render */
-        render(&g, road);
+        char hud[64];
+        snprintf(hud, sizeof(hud), "Score:%d  Speed:%d  Quit:q", g.score, g.speed_level);
+        render(stdscr, &g, road, hud);
+        doupdate();
+
+        /* publish telemetry: frame time excludes the sleep */
+        uint64_t frame_end = telemetry_now_ns();
+        telemetry_tick(telem, frame_end, frame_end - frame_start, g.score, g.speed_level);
 
         /* collision check */
         if (check_collision(&g, road)) {
+            RunRecord best;
+            game_record(&g, 1, 0);
+            recorded = 1;
             mvprintw(g.rows/2, (g.cols/2)-6, "¡COLISIÓN! Punt: %d", g.score);
             mvprintw(g.rows/2 + 1, (g.cols/2)-10, "Pulse r para reiniciar o q para salir");
+            if (stats_best_for_seed(&stats, VARIANT_CHATGPT, g.run_seed, &best) == 0)
+                mvprintw(g.rows/2 + 2, (g.cols/2)-10, "Récord semilla %u: %d", g.run_seed, best.score);
             refresh();
             nodelay(stdscr, FALSE);
             int ch;
             while ((ch = getch())) {
+                if (ch == KEY_RESIZE) resize_pending = 1; /* se aplica al reanudar */
                 if (ch == 'q' || ch == 'Q') { g.running = 0; break; }
                 if (ch == 'r' || ch == 'R') {
                     /* reset game */
@@ -263,6 +661,8 @@ int main() {
                     g.speed_level = 3;
                     g.score = 0;
                     for (int i = 0; i < road->len; ++i) road->centers[i] = g.cols/2;
+                    game_start_run(&g);
+                    recorded = 0;
                     nodelay(stdscr, TRUE);
                     break;
                 }
@@ -271,11 +671,36 @@ int main() {
         }
 
         /* sleep according to speed */
-        int delay = compute_tick_us(g.speed_level);
+        int delay = compute_tick_us(&g);
         usleep(delay);
     }
 
+    if (!recorded)
+        game_record(&g, 0, 0);
     road_free(road);
+    telemetry_destroy(telem);
     end_ncurses();
     return 0;
 }
+
+int main(int argc, char **argv) {
+    int n = 0, level = -1, opt;
+    unsigned int seed = (unsigned int)time(NULL);
+    while ((opt = getopt(argc, argv, "n:s:l:")) != -1) {
+        switch (opt) {
+        case 'n': n = atoi(optarg); break;
+        case 's': seed = (unsigned int)strtoul(optarg, NULL, 10); break;
+        case 'l': level = clamp(atoi(optarg), 0, 5); break;
+        default:
+            fprintf(stderr, "Uso: %s [-n partidas] [-s semilla] [-l velocidad 0..5]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n > MAX_GAMES) n = MAX_GAMES;
+
+    stats_open(&stats); /* sin estadísticas el juego funciona igual */
+    init_ncurses();
+    int rc = n > 1 ? play_tournament(n, seed, level) : play_single(seed, level);
+    stats_close(&stats);
+    return rc;
+}
@@ -4,6 +4,7 @@
 #include <time.h>
 #include <unistd.h>
 #include <math.h>
+#include "racing_stats.h"
 
 #define ROAD_WIDTH 20
 #define DELAY 60000
@@ -16,6 +17,8 @@ int main() {
     int road_offset;
     int key;
     MEVENT event;
+    int crashed = 0;
+    uint64_t start_ms;
 
     // Inicialización de ncurses
     initscr();
@@ -45,6 +48,7 @@ int main() {
 
     // Semilla para la generación de la carretera
     srand(time(NULL));
+    start_ms = stats_now_ms();
 
     // Habilitar la entrada del ratón
     mousemask(BUTTON1_PRESSED | REPORT_MOUSE_POSITION, NULL);
@@ -120,6 +124,7 @@ int main() {
             mvprintw(max_y / 2, max_x / 2 - 5, "GAME OVER");
             refresh();
             sleep(2);
+            crashed = 1;
             break;
         }
 
@@ -139,5 +144,18 @@ int main() {
     // Finalizar ncurses
     endwin();
 
+    // Guardar la partida: la carretera es un seno fijo, así que todas
+    // comparten la semilla 0 y la puntuación son las filas recorridas
+    RunStats stats;
+    if (stats_open(&stats) == 0) {
+        RunRecord r = {0};
+        r.score = road_offset;
+        r.duration_ms = (uint32_t)(stats_now_ms() - start_ms);
+        r.crash_tick = crashed ? (uint32_t)road_offset : 0;
+        r.variant = VARIANT_GEMINI;
+        stats_append(&stats, &r);
+        stats_close(&stats);
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -1,15 +1,33 @@
 #include <ncurses.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <unistd.h>
+#include "racing_stats.h"
 
 #define ROAD_WIDTH 20    // Ancho de la pantalla/road
-#define ROAD_HEIGHT 24   // Altura de la pantalla
+#define ROAD_MIN_HEIGHT 3 // Altura mínima: fila del coche + fila nueva + una más
 #define ROAD_LANE_WIDTH 9  // Ancho de la carretera
 #define CAR_CHAR '@'     // Símbolo del coche
 #define ROAD_EDGE '| '   // Bordes de la carretera
 #define ROAD_FILL '.'    // Relleno de la carretera
 
+// Reajusta la carretera a new_h filas (p. ej. tras redimensionar el terminal).
+// Sólo se realoja el array; se conservan las filas de abajo, que son las
+// cercanas al coche, y las filas nuevas de arriba copian la más alta.
+static int *resize_road(int *road_offset, int old_h, int new_h) {
+    int d = new_h - old_h;
+    if (d < 0) {
+        memmove(road_offset, road_offset - d, sizeof(int) * new_h);
+        road_offset = realloc(road_offset, sizeof(int) * new_h);
+    } else if (d > 0) {
+        road_offset = realloc(road_offset, sizeof(int) * new_h);
+        memmove(road_offset + d, road_offset, sizeof(int) * old_h);
+        for (int i = 0; i < d; i++) road_offset[i] = road_offset[d];
+    }
+    return road_offset;
+}
+
 int main() {
     // Inicializar ncurses
     initscr();
@@ -19,12 +37,16 @@ int main() {
     nodelay(stdscr, TRUE); // No bloquear getch()
     mousemask(ALL_MOUSE_EVENTS, NULL); // Habilitar ratón
 
-    srand(time(NULL));     // Semilla para random
+    unsigned int seed = time(NULL);
+    srand(seed);           // Semilla para random
+    uint64_t start_ms = stats_now_ms();
+    int crashed = 0;
 
     int car_x = ROAD_LANE_WIDTH / 2;  // Posición inicial del coche (relativa a la carretera)
-    int car_y = ROAD_HEIGHT - 2;      // Posición Y fija del coche (cerca del fondo)
-    int road_offset[ROAD_HEIGHT];     // Offset horizontal de la carretera por fila
-    for (int i = 0; i < ROAD_HEIGHT; i++) {
+    int road_height = LINES < ROAD_MIN_HEIGHT ? ROAD_MIN_HEIGHT : LINES; // Altura de la pantalla
+    int car_y = road_height - 2;      // Posición Y fija del coche (cerca del fondo)
+    int *road_offset = malloc(sizeof(int) * road_height); // Offset horizontal de la carretera por fila
+    for (int i = 0; i < road_height; i++) {
         road_offset[i] = (ROAD_WIDTH - ROAD_LANE_WIDTH) / 2;  // Centrada inicialmente
     }
     int curve_direction = 0;  // Dirección de curva (-1 izquierda, 0 recto, 1 derecha)
@@ -34,7 +56,7 @@ int main() {
         clear();  // Limpiar pantalla
 
         // Desplazar la carretera hacia arriba (scroll)
-        for (int i = 0; i < ROAD_HEIGHT - 1; i++) {
+        for (int i = 0; i < road_height - 1; i++) {
             road_offset[i] = road_offset[i + 1];
         }
 
@@ -44,15 +66,15 @@ int main() {
             if (curve_direction < -1) curve_direction = -1;
             if (curve_direction > 1) curve_direction = 1;
         }
-        road_offset[ROAD_HEIGHT - 1] = road_offset[ROAD_HEIGHT - 2] + curve_direction;
+        road_offset[road_height - 1] = road_offset[road_height - 2] + curve_direction;
         // Limitar offset para no salirse de la pantalla
-        if (road_offset[ROAD_HEIGHT - 1] < 0) road_offset[ROAD_HEIGHT - 1] = 0;
-        if (road_offset[ROAD_HEIGHT - 1] > ROAD_WIDTH - ROAD_LANE_WIDTH) {
-            road_offset[ROAD_HEIGHT - 1] = ROAD_WIDTH - ROAD_LANE_WIDTH;
+        if (road_offset[road_height - 1] < 0) road_offset[road_height - 1] = 0;
+        if (road_offset[road_height - 1] > ROAD_WIDTH - ROAD_LANE_WIDTH) {
+            road_offset[road_height - 1] = ROAD_WIDTH - ROAD_LANE_WIDTH;
         }
 
         // Dibujar la carretera
-        for (int y = 0; y < ROAD_HEIGHT; y++) {
+        for (int y = 0; y < road_height; y++) {
             mvaddch(y, road_offset[y], ROAD_EDGE);                     // Borde izquierdo
             mvaddch(y, road_offset[y] + ROAD_LANE_WIDTH - 1, ROAD_EDGE);  // Borde derecho
             for (int x = 1; x < ROAD_LANE_WIDTH - 1; x++) {
@@ -82,6 +104,13 @@ int main() {
                     }
                 }
             }
+        } else if (ch == KEY_RESIZE) {
+            // ncurses ya ha hecho resizeterm al recibir SIGWINCH: ajustar la altura
+            // sin reiniciar; el clear() de cada frame repinta la pantalla entera
+            int new_h = LINES < ROAD_MIN_HEIGHT ? ROAD_MIN_HEIGHT : LINES;
+            road_offset = resize_road(road_offset, road_height, new_h);
+            road_height = new_h;
+            car_y = road_height - 2;
         } else if (ch == KEY_LEFT) {
             car_x--;
         } else if (ch == KEY_RIGHT) {
@@ -96,9 +125,10 @@ int main() {
 
         // Verificar colisión (si coche toca borde)
         if (car_x <= 0 || car_x >= ROAD_LANE_WIDTH - 1) {
-            mvprintw(ROAD_HEIGHT / 2, (ROAD_WIDTH - 10) / 2, "¡Game Over!");
+            mvprintw(road_height / 2, (ROAD_WIDTH - 10) / 2, "¡Game Over!");
             refresh();
             sleep(2);
+            crashed = 1;
             break;
         }
 
@@ -107,5 +137,19 @@ int main() {
     }
 
     endwin();  // Finalizar ncurses
+    free(road_offset);
+
+    // Guardar la partida en las estadísticas persistentes
+    RunStats stats;
+    if (stats_open(&stats) == 0) {
+        RunRecord r = {0};
+        r.seed = seed;
+        r.score = score;
+        r.duration_ms = (uint32_t)(stats_now_ms() - start_ms);
+        r.crash_tick = crashed ? (uint32_t)score : 0;  // un tick por punto
+        r.variant = VARIANT_GROCK;
+        stats_append(&stats, &r);
+        stats_close(&stats);
+    }
     return 0;
 }
\ No newline at end of file
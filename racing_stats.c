@@ -0,0 +1,112 @@
+/* racing_stats.c
+   Consulta las estadísticas persistentes que guardan los juegos.
+   Uso:
+     racing-stats [-n N]    -> leaderboard (top N, por defecto 10; sin partidas del bot)
+     racing-stats -s SEED [-v VARIANTE]
+                            -> mejor partida con esa semilla (variante por defecto: chatgpt)
+     racing-stats -r        -> regenerar el índice desde el log
+   Ficheros: $RACING_STATS.{log,idx} o ~/.racing_stats.{log,idx}
+   Compilar:
+     gcc -o racing-stats racing_stats.c
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "racing_stats.h"
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static const char *variant_names[] = { "chatgpt", "gemini", "grock", "toni" };
+
+static const char *variant_name(int v) {
+    return v >= 0 && v < 4 ? variant_names[v] : "?";
+}
+
+/* nombre o número de variante; -1 si no existe */
+static int parse_variant(const char *arg) {
+    for (int v = 0; v < 4; ++v)
+        if (strcmp(arg, variant_names[v]) == 0)
+            return v;
+    char *end;
+    long v = strtol(arg, &end, 10);
+    return *end == '\0' && v >= 0 && v < 4 ? (int)v : -1;
+}
+
+static void print_record(int rank, const RunRecord *r) {
+    char when[32];
+    time_t t = (time_t)r->end_time;
+    strftime(when, sizeof(when), "%Y-%m-%d %H:%M", localtime(&t));
+    printf("%4d %8d %-8s %10u %8.1fs %5u %10u  %s\n", rank, r->score, variant_name(r->variant),
+           r->seed, r->duration_ms / 1000.0, r->max_speed, r->crash_tick, when);
+}
+
+static void print_header(void) {
+    printf("%4s %8s %-8s %10s %9s %5s %10s  %s\n",
+           "#", "SCORE", "VARIANT", "SEED", "DURATION", "SPEED", "CRASH", "WHEN");
+}
+
+int main(int argc, char **argv) {
+    int n = 10, rebuild = 0, by_seed = 0, variant = VARIANT_CHATGPT, opt;
+    uint32_t seed = 0;
+    while ((opt = getopt(argc, argv, "n:s:v:r")) != -1) {
+        switch (opt) {
+        case 'n': n = atoi(optarg); break;
+        case 's': seed = (uint32_t)strtoul(optarg, NULL, 10); by_seed = 1; break;
+        case 'v':
+            variant = parse_variant(optarg);
+            if (variant < 0) {
+                fprintf(stderr, "Variante desconocida: %s (chatgpt, gemini, grock, toni)\n", optarg);
+                return 1;
+            }
+            break;
+        case 'r': rebuild = 1; break;
+        default:
+            fprintf(stderr, "Uso: %s [-n N] [-s semilla [-v variante]] [-r]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n < 1) n = 1;
+    if (n > STATS_TOP_N) n = STATS_TOP_N;
+
+    RunStats s;
+    if (stats_open(&s) < 0) {
+        perror("racing-stats");
+        return 1;
+    }
+
+    uint64_t t0 = now_ns();
+    if (rebuild) {
+        if (stats_rebuild_index(&s) < 0) {
+            perror("racing-stats");
+            stats_close(&s);
+            return 1;
+        }
+        printf("Índice regenerado: %llu partidas\n", (unsigned long long)atomic_load(&s.log->next));
+    } else if (by_seed) {
+        RunRecord r;
+        if (stats_best_for_seed(&s, variant, seed, &r) == 0) {
+            print_header();
+            print_record(1, &r);
+        } else {
+            printf("Ninguna partida de %s con la semilla %u\n", variant_name(variant), seed);
+        }
+    } else {
+        RunRecord top[STATS_TOP_N];
+        int k = stats_top(&s, top, n);
+        print_header();
+        for (int i = 0; i < k; ++i)
+            print_record(i + 1, &top[i]);
+    }
+    uint64_t t1 = now_ns();
+    printf("(%llu partidas, consulta en %.1f us)\n",
+           (unsigned long long)atomic_load(&s.log->next), (t1 - t0) / 1000.0);
+
+    stats_close(&s);
+    return 0;
+}
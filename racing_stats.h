@@ -0,0 +1,533 @@
+/* racing_stats.h
+   Estadísticas persistentes de partidas: log de registros de tamaño fijo
+   en un fichero mapeado en memoria, más un índice mapeado con el top-N y
+   el mejor registro por semilla.
+
+   Ficheros ($RACING_STATS o ~/.racing_stats por defecto):
+     <base>.log  cabecera de 4 KiB + RunRecord[]
+     <base>.idx  cabecera + top[STATS_TOP_N] + tabla hash por (variante, semilla)
+   Las partidas del bot (RUN_BOT) sólo van al log: no entran en el top-N ni
+   en el récord por semilla, que son de partidas de personas.
+
+   Concurrencia entre procesos sin lock global:
+     - append reserva su hueco con un fetch_add atómico sobre la cabecera
+       del log, escribe el registro y lo publica con committed;
+     - el log crece con posix_fallocate, que nunca encoge el fichero aunque
+       dos procesos lo amplíen a la vez;
+     - top-N y mejor-por-semilla son palabras de 64 bits (score|registro)
+       que se actualizan con CAS, así que las consultas sólo leen el índice;
+     - regenerar el índice (racing-stats -r) lo construye en un fichero
+       temporal, lo instala con rename() y marca el viejo como retirado:
+       quien lo tenga mapeado lo reabre y repite su inserción.
+
+   Límite de la tabla por semilla: STATS_SEED_SLOTS huecos fijos con sondeo
+   lineal de hasta STATS_MAX_PROBE. chatgpt y grock siembran con time(NULL),
+   así que cada partida es una clave nueva. Con semillas consecutivas la
+   tabla aguanta hasta ~4M claves (variante, semilla), y con semillas
+   aleatorias las primeras claves sin hueco aparecen hacia ~2.5M. Una clave
+   sin hueco no se indexa, y "mejor con esta semilla" recorre el log (O(n))
+   para las claves de esa zona. Para más partidas hay que subir
+   STATS_SEED_BITS y borrar <base>.idx, que se regenera desde el log.
+*/
+
+#ifndef RACING_STATS_H
+#define RACING_STATS_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define STATS_MAGIC       0x53544152u /* "RATS" */
+#define STATS_INIT        0x54494E49u /* "INIT": cabecera reclamada, campos a medio escribir */
+#define STATS_RETIRED     0x44414544u /* "DEAD": índice sustituido por uno regenerado */
+#define STATS_VERSION     1
+#define STATS_INDEX_VERSION 2         /* 2: clave por (variante, semilla) */
+#define STATS_HEADER_SIZE 4096
+#define STATS_GROW        1024        /* registros por ampliación del log */
+#define STATS_TOP_N       64
+#define STATS_SEED_BITS   22          /* 4M huecos: fichero disperso de 64 MiB (ver límite arriba) */
+#define STATS_SEED_SLOTS  (1u << STATS_SEED_BITS)
+#define STATS_MAX_PROBE   64
+
+/* variantes del juego */
+enum { VARIANT_CHATGPT, VARIANT_GEMINI, VARIANT_GROCK, VARIANT_T };
+
+/* RunRecord.flags */
+#define RUN_BOT           0x01        /* la jugó el bot del modo torneo */
+
+/* Un registro por partida terminada (32 bytes) */
+typedef struct {
+    uint32_t seed;
+    int32_t  score;
+    uint32_t duration_ms;
+    uint32_t crash_tick;        /* 0 si se salió sin chocar */
+    int64_t  end_time;          /* time(NULL) al terminar */
+    uint16_t max_speed;
+    uint8_t  variant;
+    uint8_t  flags;             /* RUN_* */
+    _Atomic uint32_t committed; /* 1 cuando el registro está completo */
+} RunRecord;
+
+typedef struct {
+    _Atomic uint32_t magic;
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t pad;
+    _Atomic uint64_t next;      /* siguiente hueco a reservar */
+} StatsLogHeader;
+
+typedef struct {
+    _Atomic uint64_t key;       /* stats_seed_key(variant, seed), 0 = libre */
+    _Atomic uint64_t best;      /* stats_pack(score, registro) */
+} StatsSeedSlot;
+
+typedef struct {
+    _Atomic uint32_t magic;
+    uint32_t version;
+    uint32_t top_n;
+    uint32_t seed_slots;
+    _Atomic uint64_t top[STATS_TOP_N]; /* sin ordenar; 0 = libre */
+    _Alignas(4096) StatsSeedSlot seeds[]; /* la cabecera ocupa su propia página */
+} StatsIndex;
+
+#define STATS_INDEX_SIZE (sizeof(StatsIndex) + (size_t)STATS_SEED_SLOTS * sizeof(StatsSeedSlot))
+
+typedef struct {
+    int fd_log;
+    StatsLogHeader *log;
+    size_t log_len;             /* bytes mapeados del log */
+    StatsIndex *idx;
+} RunStats;
+
+/* score en los 32 bits altos (con sesgo para que compare como unsigned),
+   índice del registro en los bajos. 0 nunca es un valor válido. */
+static inline uint64_t stats_pack(int32_t score, uint64_t rec) {
+    return ((uint64_t)((uint32_t)score ^ 0x80000000u) << 32) | (uint32_t)(rec + 1);
+}
+static inline uint64_t stats_unpack_rec(uint64_t v) { return (uint32_t)v - 1; }
+
+static inline uint64_t stats_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+static inline void stats_path(char *buf, size_t len, const char *ext) {
+    const char *base = getenv("RACING_STATS");
+    if (base && *base) {
+        snprintf(buf, len, "%s%s", base, ext);
+    } else {
+        const char *home = getenv("HOME");
+        snprintf(buf, len, "%s/.racing_stats%s", home ? home : ".", ext);
+    }
+}
+
+/* (re)mapea el log para que cubra al menos need bytes, ampliándolo si hace falta */
+static inline int stats_map_log(RunStats *s, size_t need) {
+    struct stat st;
+    if (fstat(s->fd_log, &st) < 0)
+        return -1;
+    if ((size_t)st.st_size < need) {
+        size_t chunk = (size_t)STATS_GROW * sizeof(RunRecord);
+        size_t size = STATS_HEADER_SIZE + (need - STATS_HEADER_SIZE + chunk - 1) / chunk * chunk;
+        if (posix_fallocate(s->fd_log, 0, (off_t)size) != 0)
+            return -1;
+        st.st_size = (off_t)size;
+    }
+    void *p = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, s->fd_log, 0);
+    if (p == MAP_FAILED)
+        return -1;
+    if (s->log)
+        munmap(s->log, s->log_len);
+    s->log = p;
+    s->log_len = (size_t)st.st_size;
+    return 0;
+}
+
+static inline RunRecord *stats_record(RunStats *s, uint64_t i) {
+    size_t end = STATS_HEADER_SIZE + (i + 1) * sizeof(RunRecord);
+    if (end > s->log_len && stats_map_log(s, end) < 0)
+        return NULL;
+    return (RunRecord *)((char *)s->log + STATS_HEADER_SIZE) + i;
+}
+
+/* top-N: reemplaza el mínimo con CAS; el valor desplazado se reinserta,
+   así una carrera entre dos procesos nunca pierde una entrada mejor */
+static inline void stats_top_insert(StatsIndex *x, uint64_t v) {
+    for (;;) {
+        int m = 0;
+        uint64_t mv = UINT64_MAX;
+        for (int i = 0; i < STATS_TOP_N; ++i) {
+            uint64_t cur = atomic_load_explicit(&x->top[i], memory_order_relaxed);
+            if (cur == v)
+                return; /* ya está (reconstrucción concurrente) */
+            if (cur < mv) { mv = cur; m = i; }
+        }
+        if (v <= mv)
+            return;
+        if (atomic_compare_exchange_weak(&x->top[m], &mv, v)) {
+            if (mv == 0)
+                return;
+            v = mv;
+        }
+    }
+}
+
+/* cada variante genera su carretera de forma distinta: la misma semilla
+   en dos variantes son carreteras distintas, así que van en claves distintas */
+static inline uint64_t stats_seed_key(int variant, uint32_t seed) {
+    return ((uint64_t)(uint8_t)variant << 32 | seed) + 1;
+}
+
+/* hueco de la clave en la tabla. Con create=0 devuelve NULL si no está;
+   *full indica que la búsqueda agotó STATS_MAX_PROBE sin encontrar hueco libre */
+static inline StatsSeedSlot *stats_seed_slot(StatsIndex *x, uint64_t key, int create, int *full) {
+    uint32_t h = (uint32_t)((key * 0x9E3779B97F4A7C15ull) >> (64 - STATS_SEED_BITS));
+    *full = 0;
+    for (int p = 0; p < STATS_MAX_PROBE; ++p) {
+        StatsSeedSlot *sl = &x->seeds[(h + p) & (STATS_SEED_SLOTS - 1)];
+        uint64_t k = atomic_load_explicit(&sl->key, memory_order_acquire);
+        if (k == key)
+            return sl;
+        if (k == 0) {
+            if (!create)
+                return NULL;
+            if (atomic_compare_exchange_strong(&sl->key, &k, key) || k == key)
+                return sl;
+        }
+    }
+    *full = 1;
+    return NULL;
+}
+
+static inline void stats_index_insert(StatsIndex *x, const RunRecord *r, uint64_t rec) {
+    if (r->flags & RUN_BOT)
+        return;
+    uint64_t v = stats_pack(r->score, rec);
+    stats_top_insert(x, v);
+    int full;
+    StatsSeedSlot *sl = stats_seed_slot(x, stats_seed_key(r->variant, r->seed), 1, &full);
+    if (!sl)
+        return; /* tabla saturada en esta zona: la consulta cae al log */
+    uint64_t cur = atomic_load_explicit(&sl->best, memory_order_relaxed);
+    while (cur < v && !atomic_compare_exchange_weak(&sl->best, &cur, v)) { }
+}
+
+/* indexa los registros confirmados del rango [from, to) del log;
+   devuelve el primero que aún no estaba confirmado (to si ninguno) */
+static inline uint64_t stats_index_fill(RunStats *s, StatsIndex *x, uint64_t from, uint64_t to) {
+    uint64_t pending = to;
+    for (uint64_t i = from; i < to; ++i) {
+        RunRecord *r = stats_record(s, i);
+        if (r && atomic_load(&r->committed))
+            stats_index_insert(x, r, i);
+        else if (pending == to)
+            pending = i;
+    }
+    return pending;
+}
+
+/* Reclama la cabecera (de len bytes) de un fichero recién creado.
+   1: la hemos creado nosotros, el llamador escribe los campos y la publica;
+   0: ya existía y está publicada, el llamador valida sus campos;
+   -1: fichero ajeno (magic distinto o cabecera no vacía) o creador muerto a medias */
+static inline int stats_claim_header(_Atomic uint32_t *magic, size_t len) {
+    for (int tries = 0; tries < 1000; ++tries) {
+        uint32_t m = atomic_load(magic);
+        if (m == STATS_MAGIC)
+            return 0;
+        if (m == STATS_INIT) {
+            usleep(1000); /* otro proceso la está escribiendo */
+            continue;
+        }
+        if (m != 0)
+            return -1;
+        /* magic a cero sólo es un fichero nuevo si toda la cabecera está a cero;
+           si magic cambió mientras mirábamos, otro proceso la acaba de reclamar */
+        const unsigned char *p = (const unsigned char *)magic;
+        size_t i = sizeof(*magic);
+        while (i < len && !p[i])
+            ++i;
+        if (i < len) {
+            if (atomic_load(magic) == 0)
+                return -1;
+            continue;
+        }
+        if (atomic_compare_exchange_strong(magic, &m, STATS_INIT))
+            return 1;
+    }
+    return -1;
+}
+
+static inline void stats_publish_header(_Atomic uint32_t *magic) {
+    atomic_store_explicit(magic, STATS_MAGIC, memory_order_release);
+}
+
+/* mapea <base>.idx, creándolo (y llenándolo desde el log) si no existe.
+   0 si ok; -1 con s->idx == NULL si no se puede */
+static inline int stats_map_index(RunStats *s) {
+    char path[512];
+    struct stat st;
+    StatsIndex *x;
+    stats_path(path, sizeof(path), ".idx");
+    for (;;) {
+        int fd = open(path, O_RDWR | O_CREAT, 0644);
+        if (fd < 0)
+            return -1;
+        /* tamaño fijo: ftruncate de un fichero vacío a la misma constante es
+           idempotente; cualquier otro tamaño (p. ej. truncado) daría SIGBUS al
+           tocar seeds[] */
+        if (fstat(fd, &st) < 0 || (st.st_size == 0 && ftruncate(fd, STATS_INDEX_SIZE) < 0)
+            || (st.st_size != 0 && (size_t)st.st_size != STATS_INDEX_SIZE)) {
+            close(fd);
+            errno = EINVAL;
+            return -1;
+        }
+        x = mmap(NULL, STATS_INDEX_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (x == MAP_FAILED)
+            return -1;
+        if (atomic_load(&x->magic) != STATS_RETIRED)
+            break;
+        /* lo retiraron mientras lo abríamos: el nuevo ya está en su sitio */
+        munmap(x, STATS_INDEX_SIZE);
+    }
+    int created = stats_claim_header(&x->magic, sizeof(StatsIndex));
+    if (created == 0 && (x->version != STATS_INDEX_VERSION || x->top_n != STATS_TOP_N
+                         || x->seed_slots != STATS_SEED_SLOTS))
+        created = -1; /* otro layout: borrar <base>.idx para regenerarlo desde el log */
+    if (created < 0) {
+        munmap(x, STATS_INDEX_SIZE);
+        errno = EINVAL;
+        return -1;
+    }
+    if (created) {
+        x->version = STATS_INDEX_VERSION;
+        x->top_n = STATS_TOP_N;
+        x->seed_slots = STATS_SEED_SLOTS;
+        stats_publish_header(&x->magic);
+        /* índice borrado: se llena desde el log; las inserciones son idempotentes,
+           así que da igual que otros procesos inserten a la vez */
+        stats_index_fill(s, x, 0, atomic_load(&s->log->next));
+    }
+    s->idx = x;
+    return 0;
+}
+
+/* si otro proceso regeneró el índice, reabrir el nuevo. 0 si hay índice */
+static inline int stats_check_index(RunStats *s) {
+    if (s->idx && atomic_load(&s->idx->magic) == STATS_RETIRED) {
+        munmap(s->idx, STATS_INDEX_SIZE);
+        s->idx = NULL;
+        stats_map_index(s);
+    }
+    return s->idx ? 0 : -1;
+}
+
+/* Regenera el índice desde el log sin tocar el que están usando otros
+   procesos: se construye en <base>.idx.tmp.<pid> y se instala con rename().
+   Los appends siguen sin lock; el flock sólo serializa dos regeneraciones. */
+static inline int stats_rebuild_index(RunStats *s) {
+    char path[512], tmp[600];
+    stats_path(path, sizeof(path), ".idx");
+    snprintf(tmp, sizeof(tmp), "%s.tmp.%d", path, (int)getpid());
+    if (flock(s->fd_log, LOCK_EX) < 0)
+        return -1;
+    stats_check_index(s); /* una regeneración anterior pudo sustituirlo */
+
+    int rc = -1;
+    int fd = open(tmp, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        goto out;
+    if (ftruncate(fd, STATS_INDEX_SIZE) < 0) {
+        close(fd);
+        unlink(tmp);
+        goto out;
+    }
+    StatsIndex *x = mmap(NULL, STATS_INDEX_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (x == MAP_FAILED) {
+        unlink(tmp);
+        goto out;
+    }
+    x->version = STATS_INDEX_VERSION;
+    x->top_n = STATS_TOP_N;
+    x->seed_slots = STATS_SEED_SLOTS;
+    stats_publish_header(&x->magic);
+    /* ponerse al día antes de instalarlo, para que quien lo abra ya lo vea completo */
+    uint64_t pending = 0, n;
+    do {
+        n = atomic_load(&s->log->next);
+        pending = stats_index_fill(s, x, pending, n);
+    } while (n != atomic_load(&s->log->next));
+    if (rename(tmp, path) < 0) {
+        munmap(x, STATS_INDEX_SIZE);
+        unlink(tmp);
+        goto out;
+    }
+
+    /* Retirar el viejo. Un append que vea RETIRED repite su inserción en
+       el nuevo; uno que no lo vea confirmó su registro antes (todo seq_cst),
+       así que el segundo recorrido, desde el primero que no estaba
+       confirmado, lo encuentra. */
+    StatsIndex *old = s->idx;
+    s->idx = x;
+    if (old) {
+        atomic_store(&old->magic, STATS_RETIRED);
+        munmap(old, STATS_INDEX_SIZE);
+    }
+    stats_index_fill(s, x, pending, atomic_load(&s->log->next));
+    rc = 0;
+out:
+    flock(s->fd_log, LOCK_UN);
+    return rc;
+}
+
+static inline void stats_close(RunStats *s) {
+    if (s->idx)
+        munmap(s->idx, STATS_INDEX_SIZE);
+    if (s->log)
+        munmap(s->log, s->log_len);
+    if (s->fd_log >= 0)
+        close(s->fd_log);
+    s->idx = NULL;
+    s->log = NULL;
+    s->fd_log = -1;
+}
+
+/* 0 si ok, -1 si no se puede (el juego sigue sin estadísticas) */
+static inline int stats_open(RunStats *s) {
+    char path[512];
+    memset(s, 0, sizeof(*s));
+    s->fd_log = -1;
+
+    struct stat st;
+    stats_path(path, sizeof(path), ".log");
+    s->fd_log = open(path, O_RDWR | O_CREAT, 0644);
+    if (s->fd_log < 0 || fstat(s->fd_log, &st) < 0)
+        goto fail;
+    /* sólo se amplía un fichero vacío: uno no vacío sin cabecera completa es ajeno */
+    if (st.st_size != 0 && st.st_size < STATS_HEADER_SIZE) {
+        errno = EINVAL;
+        goto fail;
+    }
+    if (stats_map_log(s, STATS_HEADER_SIZE) < 0)
+        goto fail;
+    int created = stats_claim_header(&s->log->magic, STATS_HEADER_SIZE);
+    if (created < 0) {
+        errno = EINVAL;
+        goto fail;
+    }
+    if (created) {
+        s->log->version = STATS_VERSION;
+        s->log->record_size = sizeof(RunRecord);
+        stats_publish_header(&s->log->magic);
+    } else if (s->log->version != STATS_VERSION || s->log->record_size != sizeof(RunRecord)) {
+        errno = EINVAL;
+        goto fail;
+    }
+
+    if (stats_map_index(s) < 0)
+        goto fail;
+    return 0;
+
+fail:
+    stats_close(s);
+    return -1;
+}
+
+/* añade un registro; devuelve su índice o -1 */
+static inline int64_t stats_append(RunStats *s, const RunRecord *in) {
+    if (!s->log)
+        return -1;
+    uint64_t i = atomic_fetch_add(&s->log->next, 1);
+    RunRecord *r = stats_record(s, i);
+    if (!r)
+        return -1;
+    /* el índice se alimenta de una copia local: reabrirlo puede llenarlo
+       desde el log, y eso remapea s->log y deja r apuntando a memoria liberada */
+    RunRecord c = {0};
+    c.seed = in->seed;
+    c.score = in->score;
+    c.duration_ms = in->duration_ms;
+    c.crash_tick = in->crash_tick;
+    c.end_time = in->end_time ? in->end_time : (int64_t)time(NULL);
+    c.max_speed = in->max_speed;
+    c.variant = in->variant;
+    c.flags = in->flags;
+    memcpy(r, &c, offsetof(RunRecord, committed));
+    atomic_store(&r->committed, 1); /* seq_cst: ver stats_rebuild_index */
+    if (stats_check_index(s) == 0) {
+        stats_index_insert(s->idx, &c, i);
+        if (atomic_load(&s->idx->magic) == STATS_RETIRED && stats_check_index(s) == 0)
+            stats_index_insert(s->idx, &c, i); /* regenerado mientras insertábamos */
+    }
+    return (int64_t)i;
+}
+
+static inline int stats_cmp_desc(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? 1 : x > y ? -1 : 0;
+}
+
+/* leaderboard: hasta n registros, de mayor a menor score */
+static inline int stats_top(RunStats *s, RunRecord *out, int n) {
+    uint64_t v[STATS_TOP_N];
+    int k = 0;
+    if (stats_check_index(s) < 0)
+        return 0;
+    for (int i = 0; i < STATS_TOP_N; ++i) {
+        uint64_t cur = atomic_load_explicit(&s->idx->top[i], memory_order_relaxed);
+        if (cur) v[k++] = cur;
+    }
+    qsort(v, k, sizeof(uint64_t), stats_cmp_desc);
+    int m = 0;
+    for (int i = 0; i < k && m < n; ++i) {
+        RunRecord *r = stats_record(s, stats_unpack_rec(v[i]));
+        if (r)
+            memcpy(&out[m++], r, sizeof(RunRecord));
+    }
+    return m;
+}
+
+/* mejor partida de esta variante con esta semilla: 0 si existe, -1 si no */
+static inline int stats_best_for_seed(RunStats *s, int variant, uint32_t seed, RunRecord *out) {
+    int full;
+    if (stats_check_index(s) < 0)
+        return -1;
+    StatsSeedSlot *sl = stats_seed_slot(s->idx, stats_seed_key(variant, seed), 0, &full);
+    if (sl) {
+        uint64_t best = atomic_load_explicit(&sl->best, memory_order_relaxed);
+        RunRecord *r = best ? stats_record(s, stats_unpack_rec(best)) : NULL;
+        if (!r)
+            return -1;
+        memcpy(out, r, sizeof(RunRecord));
+        return 0;
+    }
+    if (!full)
+        return -1;
+    /* zona saturada: la semilla puede no estar indexada, recorrer el log */
+    int found = -1;
+    uint64_t n = atomic_load(&s->log->next);
+    for (uint64_t i = 0; i < n; ++i) {
+        RunRecord *r = stats_record(s, i);
+        if (r && atomic_load_explicit(&r->committed, memory_order_acquire)
+            && r->seed == seed && r->variant == variant && !(r->flags & RUN_BOT) && (found < 0 || r->score > out->score)) {
+            memcpy(out, r, sizeof(RunRecord));
+            found = 0;
+        }
+    }
+    return found;
+}
+
+#endif /* RACING_STATS_H */
@@ -17,6 +17,7 @@ typedef struct ship_s
 ship_t ship = {0, 0};
 clock_t start, end;
 int rows, cols;
+int center = 0; // centro de la última fila pintada (0 = aún sin carretera)
 
 #define ROAD_WIDTH       12
 #define BACKGROUND_WIDTH rows/2
@@ -34,6 +35,7 @@ void setPositionShip(int x, int y);
 ship_t getPositionShip(void);
 void handler_input(int key);
 void scrolling(void);
+void resizeScreen(void);
 
 int main(void) {
     
@@ -119,11 +121,10 @@ void drawShip(void) {
 
 void drawBackground(int first, int last) {
 
-    /* HAY QUE GUARDAR EL CENTER EN UNA GLOBAL, PARA */
-
-    static int center = 80; //IMPORTANTE: STATIC, 80 initial value must be constant.
-    int limit_right = 80 + BACKGROUND_WIDTH;
-    int limit_left = 80 - BACKGROUND_WIDTH;
+    /* center es global para poder reajustarlo al redimensionar */
+    if (center == 0) center = cols / 2;
+    int limit_right = cols / 2 + BACKGROUND_WIDTH;
+    int limit_left = cols / 2 - BACKGROUND_WIDTH;
 
     for (int i = first; i <= last; i++) //pintar las filas
     {
@@ -150,7 +151,7 @@ void drawBackground(int first, int last) {
         mvwprintw(stdscr, i, x - ROAD_WIDTH/2, "|");
         mvwhline(stdscr, i, 0, '*', x - ROAD_WIDTH/2);
         mvwprintw(stdscr, i, x + ROAD_WIDTH/2, "|");
-        mvwhline(stdscr, i, x + ROAD_WIDTH/2 + 1 , '*', 100); //solo pinta hasta el boundary
+        mvwhline(stdscr, i, x + ROAD_WIDTH/2 + 1 , '*', cols); //solo pinta hasta el boundary
         
         center = x;
     }
@@ -188,6 +189,9 @@ void handler_input(int key) {
         setPositionShip(0, -1);
         drawShip();
         break;
+    case KEY_RESIZE: // ncurses ya ha hecho resizeterm al recibir SIGWINCH
+        resizeScreen();
+        break;
     case 32: // también podriamos haber puesto ' ' (= SPACE)
         /* Para salir del sleep antes hay que enviar una señal tipo crtl+c */
         sleep(5);
@@ -196,4 +200,31 @@ void handler_input(int key) {
     }
     
     flushinp(); // Clear the input buffer to avoid retards
+}
+
+/* Reajusta la carretera y la nave al nuevo tamaño del terminal sin reiniciar.
+   La pantalla es el único almacén de filas: si sólo cambia la altura se
+   pintan únicamente las filas nuevas; si cambia el ancho se reescala el
+   centro y se repinta todo una vez. */
+void resizeScreen(void) {
+    int old_rows = rows, old_cols = cols;
+    getmaxyx(stdscr, rows, cols);
+
+    clearShip();
+    ship.pos_x = ship.pos_x * cols / old_cols;
+    if (ship.pos_x < 3) ship.pos_x = 3;
+    if (ship.pos_x > cols - 4) ship.pos_x = cols - 4;
+    if (ship.pos_y > rows - 4) ship.pos_y = rows - 4;
+    if (ship.pos_y < 1) ship.pos_y = 1;
+
+    if (cols != old_cols) {
+        center = center * cols / old_cols;
+        clear();
+        drawBackground(1, rows);
+    } else if (rows > old_rows) {
+        int top = center; // las filas nuevas no deben mover el centro de la fila 1
+        drawBackground(old_rows, rows);
+        center = top;
+    }
+    drawShip();
 }
\ No newline at end of file
@@ -0,0 +1,153 @@
+/* racing_telemetry.h
+   Telemetría en vivo por memoria compartida POSIX.
+   Cada partida publica un segmento /dev/shm/racing.<pid>.<slot> que
+   racing-top lee sin tocar el bucle ni el terminal del juego (slot 0 en
+   modo normal, un slot por partida en modo torneo).
+
+   Protocolo seqlock (un solo escritor por segmento, N lectores):
+     - el escritor pone seq impar, escribe los campos y pone seq par;
+     - el lector copia los campos y reintenta si seq era impar o cambió.
+   Publicar cuesta unas pocas stores por tick: clock_gettime(CLOCK_MONOTONIC)
+   va por el vDSO, así que no hay syscalls en el camino caliente.
+
+   Los bytes escritos al terminal no pasan por nuestro código (ncurses hace
+   write() directamente sobre el fd), así que racing-top los toma del
+   contador wchar que ya mantiene el kernel en /proc/<pid>/io.
+*/
+
+#ifndef RACING_TELEMETRY_H
+#define RACING_TELEMETRY_H
+
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TELEMETRY_MAGIC   0x45434152u /* "RACE" */
+#define TELEMETRY_VERSION 2
+#define TELEMETRY_PREFIX  "racing."   /* nombre en /dev/shm */
+#define TELEMETRY_BUCKETS 24          /* histograma log2 de frame time en us */
+
+/* Layout del segmento: sólo tipos de tamaño fijo, lo comparten procesos */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    int32_t  pid;
+    int32_t  slot;
+    _Atomic uint32_t seq;       /* impar mientras el escritor actualiza */
+    uint64_t start_ns;          /* CLOCK_MONOTONIC al arrancar */
+    uint64_t last_tick_ns;      /* CLOCK_MONOTONIC del último tick */
+    uint64_t ticks;
+    uint64_t input_events;
+    int32_t  score;
+    int32_t  speed_level;
+    uint64_t frame_hist[TELEMETRY_BUCKETS]; /* bucket b: frame < 2^b us */
+} Telemetry;
+
+static inline uint64_t telemetry_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline void telemetry_shm_name(char *buf, size_t len, int pid, int slot) {
+    snprintf(buf, len, "/" TELEMETRY_PREFIX "%d.%d", pid, slot);
+}
+
+/* Crea y mapea el segmento de la partida slot del proceso actual. NULL si
+   no se puede: el juego sigue funcionando igual sin telemetría. */
+static inline Telemetry *telemetry_create(int slot) {
+    char name[64];
+    telemetry_shm_name(name, sizeof(name), (int)getpid(), slot);
+    int fd = shm_open(name, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd < 0)
+        return NULL;
+    if (ftruncate(fd, sizeof(Telemetry)) < 0) {
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+    Telemetry *t = mmap(NULL, sizeof(Telemetry), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (t == MAP_FAILED) {
+        shm_unlink(name);
+        return NULL;
+    }
+    /* ftruncate deja el segmento a cero; magic va al final para que un
+       lector nunca vea un segmento a medio inicializar */
+    t->version = TELEMETRY_VERSION;
+    t->pid = (int32_t)getpid();
+    t->slot = slot;
+    t->start_ns = telemetry_now_ns();
+    atomic_store_explicit(&t->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    t->magic = TELEMETRY_MAGIC;
+    return t;
+}
+
+static inline void telemetry_destroy(Telemetry *t) {
+    if (!t) return;
+    char name[64];
+    telemetry_shm_name(name, sizeof(name), t->pid, t->slot);
+    munmap(t, sizeof(Telemetry));
+    shm_unlink(name);
+}
+
+/* Escritor: abrir/cerrar la sección protegida por el seqlock */
+static inline void telemetry_begin(Telemetry *t) {
+    uint32_t s = atomic_load_explicit(&t->seq, memory_order_relaxed);
+    atomic_store_explicit(&t->seq, s + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static inline void telemetry_end(Telemetry *t) {
+    uint32_t s = atomic_load_explicit(&t->seq, memory_order_relaxed);
+    atomic_store_explicit(&t->seq, s + 1, memory_order_release);
+}
+
+/* bucket log2 de un frame time en microsegundos */
+static inline int telemetry_bucket(uint64_t us) {
+    int b = us ? 64 - __builtin_clzll(us) : 0;
+    return b < TELEMETRY_BUCKETS ? b : TELEMETRY_BUCKETS - 1;
+}
+
+/* Publica un tick completo. frame_ns = tiempo de trabajo del tick (sin el sleep). */
+static inline void telemetry_tick(Telemetry *t, uint64_t now_ns, uint64_t frame_ns,
+                                  int score, int speed_level) {
+    if (!t) return;
+    telemetry_begin(t);
+    t->ticks++;
+    t->last_tick_ns = now_ns;
+    t->score = score;
+    t->speed_level = speed_level;
+    t->frame_hist[telemetry_bucket(frame_ns / 1000)]++;
+    telemetry_end(t);
+}
+
+static inline void telemetry_input(Telemetry *t, int events) {
+    if (!t || !events) return;
+    telemetry_begin(t);
+    t->input_events += (uint64_t)events;
+    telemetry_end(t);
+}
+
+/* Lector: copia consistente del segmento. 0 si ok, -1 si no es válido. */
+static inline int telemetry_snapshot(const Telemetry *t, Telemetry *out) {
+    for (int tries = 0; tries < 1000; ++tries) {
+        uint32_t s1 = atomic_load_explicit((_Atomic uint32_t *)&t->seq, memory_order_acquire);
+        if (s1 & 1)
+            continue;
+        memcpy(out, (const void *)t, sizeof(Telemetry));
+        atomic_thread_fence(memory_order_acquire);
+        uint32_t s2 = atomic_load_explicit((_Atomic uint32_t *)&t->seq, memory_order_relaxed);
+        if (s1 == s2)
+            return out->magic == TELEMETRY_MAGIC && out->version == TELEMETRY_VERSION ? 0 : -1;
+    }
+    return -1;
+}
+
+#endif /* RACING_TELEMETRY_H */
@@ -0,0 +1,205 @@
+/* racing_top.c
+   Monitor externo: muestra en vivo la telemetría de todos los juegos
+   locales que publican un segmento /dev/shm/racing.<pid>.<slot>.
+   No toca el bucle ni el terminal de los juegos: sólo mapea en lectura.
+   Controles:
+     q -> salir
+   Compilar:
+     gcc -o racing-top racing_top.c -lncurses -lrt
+*/
+
+#include <ncurses.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "racing_telemetry.h"
+
+#define MAX_GAMES    64
+#define REFRESH_MS   500
+
+/* Un juego observado: segmento mapeado y la muestra anterior para calcular tasas */
+typedef struct {
+    int pid, slot;
+    const Telemetry *seg;
+    Telemetry prev;
+    uint64_t prev_ns;
+    uint64_t prev_wchar;
+    int seen;   /* marcado en cada escaneo; los no vistos se liberan */
+} Game;
+
+static Game games[MAX_GAMES];
+static int ngames = 0;
+
+static const Telemetry *map_segment(const char *name) {
+    char path[NAME_MAX + 2];
+    snprintf(path, sizeof(path), "/%s", name);
+    int fd = shm_open(path, O_RDONLY, 0);
+    if (fd < 0)
+        return NULL;
+    /* telemetry_create hace shm_open antes de ftruncate: un segmento aún
+       vacío se saltaría aquí y se mapea en el siguiente escaneo (leerlo
+       más allá del final daría SIGBUS) */
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(Telemetry)) {
+        close(fd);
+        return NULL;
+    }
+    void *p = mmap(NULL, sizeof(Telemetry), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    return p == MAP_FAILED ? NULL : p;
+}
+
+/* bytes escritos por el proceso, según el kernel (0 si no es legible) */
+static uint64_t read_wchar(int pid) {
+    char path[64], line[128];
+    unsigned long long v = 0;
+    snprintf(path, sizeof(path), "/proc/%d/io", pid);
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return 0;
+    while (fgets(line, sizeof(line), f))
+        if (sscanf(line, "wchar: %llu", &v) == 1)
+            break;
+    fclose(f);
+    return v;
+}
+
+/* busca segmentos nuevos y suelta los de procesos que ya no existen */
+static void scan_segments(void) {
+    for (int i = 0; i < ngames; ++i)
+        games[i].seen = 0;
+
+    DIR *d = opendir("/dev/shm");
+    struct dirent *e;
+    while (d && (e = readdir(d))) {
+        int pid, slot;
+        if (strncmp(e->d_name, TELEMETRY_PREFIX, strlen(TELEMETRY_PREFIX)) != 0)
+            continue;
+        if (sscanf(e->d_name + strlen(TELEMETRY_PREFIX), "%d.%d", &pid, &slot) != 2 || pid <= 0)
+            continue;
+        if (kill(pid, 0) < 0 && errno == ESRCH) {
+            /* el juego murió sin limpiar (Ctrl-C, crash) */
+            char name[64];
+            telemetry_shm_name(name, sizeof(name), pid, slot);
+            shm_unlink(name);
+            continue;
+        }
+        int i;
+        for (i = 0; i < ngames; ++i)
+            if (games[i].pid == pid && games[i].slot == slot) break;
+        if (i == ngames) {
+            if (ngames == MAX_GAMES)
+                continue;
+            const Telemetry *seg = map_segment(e->d_name);
+            if (!seg)
+                continue;
+            memset(&games[i], 0, sizeof(Game));
+            games[i].pid = pid;
+            games[i].slot = slot;
+            games[i].seg = seg;
+            ngames++;
+        }
+        games[i].seen = 1;
+    }
+    if (d)
+        closedir(d);
+
+    /* compactar la tabla */
+    int n = 0;
+    for (int i = 0; i < ngames; ++i) {
+        if (games[i].seen)
+            games[n++] = games[i];
+        else
+            munmap((void *)games[i].seg, sizeof(Telemetry));
+    }
+    ngames = n;
+}
+
+/* percentil p (0..100) del histograma log2; devuelve el límite superior del bucket en us */
+static uint64_t hist_percentile(const uint64_t *hist, double p) {
+    uint64_t total = 0, acc = 0;
+    for (int b = 0; b < TELEMETRY_BUCKETS; ++b)
+        total += hist[b];
+    if (total == 0)
+        return 0;
+    uint64_t target = (uint64_t)(total * p / 100.0);
+    for (int b = 0; b < TELEMETRY_BUCKETS; ++b) {
+        acc += hist[b];
+        if (acc > target)
+            return 1ull << b;
+    }
+    return 1ull << (TELEMETRY_BUCKETS - 1);
+}
+
+static void draw(void) {
+    erase();
+    mvprintw(0, 0, "racing-top  %d juego(s)  Quit:q", ngames);
+    attron(A_REVERSE);
+    mvprintw(2, 0, "%7s %4s %8s %7s %7s %7s %7s %10s %9s %8s %6s %5s",
+             "PID", "SLOT", "UPTIME", "TICK/s", "p50us", "p95us", "p99us",
+             "BYTES", "BYTES/s", "INPUTS", "SCORE", "SPEED");
+    attroff(A_REVERSE);
+
+    uint64_t now = telemetry_now_ns();
+    int row = 3;
+    for (int i = 0; i < ngames; ++i) {
+        Game *gm = &games[i];
+        Telemetry cur;
+        if (telemetry_snapshot(gm->seg, &cur) < 0)
+            continue;
+        /* por proceso: en modo torneo todas las partidas lo comparten */
+        uint64_t wchar = read_wchar(gm->pid);
+
+        /* tasas y percentiles sobre el intervalo desde la muestra anterior */
+        double tick_rate = 0, byte_rate = 0;
+        uint64_t delta[TELEMETRY_BUCKETS];
+        if (gm->prev_ns) {
+            double dt = (now - gm->prev_ns) / 1e9;
+            tick_rate = (cur.ticks - gm->prev.ticks) / dt;
+            byte_rate = (wchar - gm->prev_wchar) / dt;
+        }
+        for (int b = 0; b < TELEMETRY_BUCKETS; ++b)
+            delta[b] = cur.frame_hist[b] - gm->prev.frame_hist[b];
+
+        mvprintw(row++, 0, "%7d %4d %7.1fs %7.1f %7llu %7llu %7llu %10llu %9.0f %8llu %6d %5d",
+                 gm->pid, gm->slot, (now - cur.start_ns) / 1e9, tick_rate,
+                 (unsigned long long)hist_percentile(delta, 50),
+                 (unsigned long long)hist_percentile(delta, 95),
+                 (unsigned long long)hist_percentile(delta, 99),
+                 (unsigned long long)wchar, byte_rate,
+                 (unsigned long long)cur.input_events, cur.score, cur.speed_level);
+
+        gm->prev = cur;
+        gm->prev_ns = now;
+        gm->prev_wchar = wchar;
+    }
+    if (ngames == 0)
+        mvprintw(row, 0, "(no hay juegos publicando en /dev/shm/%s*)", TELEMETRY_PREFIX);
+    refresh();
+}
+
+int main() {
+    initscr();
+    cbreak();
+    noecho();
+    curs_set(0);
+    timeout(REFRESH_MS); /* getch espera como mucho un intervalo de refresco */
+
+    while (1) {
+        scan_segments();
+        draw();
+        int ch = getch();
+        if (ch == 'q' || ch == 'Q')
+            break;
+    }
+
+    for (int i = 0; i < ngames; ++i)
+        munmap((void *)games[i].seg, sizeof(Telemetry));
+    endwin();
+    return 0;
+}